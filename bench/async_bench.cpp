@@ -0,0 +1,91 @@
+//  Sequential HashMap::get() vs coroutine interleaved async_get() lookups (async_lookup.hpp), negative result:
+//  interleaved lookups are slower in all configurations
+//  Map storage size grows as dim_size^2 (every node keeps collision chain of dim_size pointers),
+//  so the biggest map is far beyond LLC size
+
+#include "async_lookup.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace LibHashMap;
+using namespace AsyncLookup;
+
+constexpr size_t lookups {1'000'000};
+
+/// @brief Run function and count time per operation
+/// @param ops Operations number
+/// @param func Benchmark body
+/// @return Nanoseconds per operation
+template<typename Func> double nsPerOp(size_t ops, Func&& func) {
+  const auto start {std::chrono::steady_clock::now()};
+  func();
+  const std::chrono::duration<double, std::nano> elapsed {std::chrono::steady_clock::now() - start};
+  return elapsed.count() / ops;
+}
+
+/// @brief Create HashMap on heap by runtime keys (HashMap could be created by initializer list only)
+template<typename Map, size_t... I> std::unique_ptr<Map> makeMap(const std::vector<typename Map::key_type>& keys, std::index_sequence<I...>) {
+  return std::make_unique<Map>(std::initializer_list<std::pair<typename Map::key_type, typename Map::mapped_type>>{{keys[I], static_cast<typename Map::mapped_type>(I)}...});
+}
+
+/// @brief Request handler, every one looks for its own part of keys
+template<typename Map> Lookup<void> request(const Map& map, const std::vector<uint32_t>& keys, size_t first, size_t step, unsigned hot_levels, size_t& sink) {
+  for (auto count {first}; count < keys.size(); count += step) {
+    sink += *co_await async_get(map, keys[count], hot_levels);
+  }
+}
+
+template<uint32_t map_size> void bench() {
+  using Map = HashMap<uint32_t, uint32_t, uint32_t, map_size>;
+  std::vector<uint32_t> keys;
+  for (uint32_t count{0}; count < map_size; ++count) {
+    keys.push_back(count * 2654435761u);
+  }
+  const auto map {makeMap<Map>(keys, std::make_index_sequence<map_size>{})};
+
+  std::vector<uint32_t> requests;
+  std::mt19937 rnd {42};
+  std::uniform_int_distribution<size_t> dist {0, map_size - 1};
+  for (size_t count{0}; count < lookups; ++count) {
+    requests.push_back(keys[dist(rnd)]);
+  }
+
+  size_t expected {0};
+  const auto sequential {nsPerOp(lookups, [&] {
+    for (auto key : requests) {
+      expected += *map->get(key);
+    }
+  })};
+  std::printf("%8u %10.1f MiB %13s %10.2f\n", map_size, sizeof(Map) / 1048576.0, "get()", sequential);
+
+  for (unsigned hot_levels : {0u, 4u, default_hot_levels, 10u}) {
+    for (size_t in_flight : {1, 8, 16, 32}) {
+      size_t sink {0};
+      const auto interleaved {nsPerOp(lookups, [&] {
+        LookupScheduler scheduler;
+        for (size_t count{0}; count < in_flight; ++count) {
+          scheduler.spawn(request(*map, requests, count, in_flight, hot_levels, sink));
+        }
+        scheduler.run();
+      })};
+      std::printf("%8u %10.1f MiB %4u %5zu co %10.2f %7.2fx\n", map_size, sizeof(Map) / 1048576.0, hot_levels, in_flight, interleaved, sequential / interleaved);
+      if (sink != expected) {
+        std::printf("Interleaved lookups result mismatch\n");
+        std::exit(EXIT_FAILURE);
+      }
+    }
+  }
+}
+
+int main() {
+  std::printf("%8s %14s %4s %8s %10s %8s\n", "entries", "storage", "hot", "lookup", "ns/op", "speedup");
+  bench<1024>();
+  bench<8192>();
+  return 0;
+}
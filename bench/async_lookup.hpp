@@ -0,0 +1,315 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Andrey Fokin lazzyfox@gmail.com.
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//  Coroutine interleaved HashMap lookups for bench/async_bench.cpp. Not a part of the library: it is kept as a
+//  negative result. async_get() / async_exists() run the same step by step search as HashMap::get() / exists()
+//  (HashMap::Search). Below top binary search levels every probe location is prefetched, then lookup gives way to
+//  next one queued in LookupScheduler running on the same thread. Without active scheduler lookup is synchronous.
+//  Interleaving does not pay off for HashMap node layout: binary search touches only node headers, one cache line
+//  per entry (512 KiB for 8192 entries), so working set fits in LLC for any map fitting in RAM (storage grows as
+//  entries^2), and coroutine switch costs more than saved L2 misses.
+
+#pragma once
+
+#include "../src/libHashMap.hpp"
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace AsyncLookup {
+
+  class LookupScheduler;
+
+  /// Scheduler running on current thread, lookups are synchronous if there is no one
+  inline thread_local LookupScheduler* active_scheduler {nullptr};
+
+  /// @brief Thread local free lists for lookup coroutine frames, frames are allocated for every lookup
+  /// and have a few distinct sizes, so they are reused instead of heap allocation
+  class FramePool {
+    public :
+      static void* allocate(size_t size) {
+        const auto bucket {(size - 1) / granularity};
+        if (bucket < buckets_number && free_lists()[bucket]) {
+          return std::exchange(free_lists()[bucket], free_lists()[bucket]->next);
+        }
+        return ::operator new(bucket < buckets_number ? (bucket + 1) * granularity : size);
+      }
+
+      static void deallocate(void* ptr, size_t size) noexcept {
+        if (const auto bucket {(size - 1) / granularity}; bucket < buckets_number) {
+          free_lists()[bucket] = ::new (ptr) FreeFrame{free_lists()[bucket]};
+        } else {
+          ::operator delete(ptr);
+        }
+      }
+
+    private :
+      struct FreeFrame {
+        FreeFrame* next;
+      };
+
+      static constexpr size_t granularity {64};
+      static constexpr size_t buckets_number {16};
+
+      /// Frames are kept until thread exit
+      static std::array<FreeFrame*, buckets_number>& free_lists() noexcept {
+        struct FreeLists {
+          std::array<FreeFrame*, buckets_number> heads{};
+          ~FreeLists() {
+            for (auto head : heads) {
+              while (head) {
+                ::operator delete(std::exchange(head, head->next));
+              }
+            }
+          }
+        };
+        static thread_local FreeLists lists;
+        return lists.heads;
+      }
+  };
+
+  /// @brief Lookup result storage for coroutine promise
+  template<typename T> struct LookupResult {
+    T result{};
+    void return_value(T val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      result = std::move(val);
+    }
+  };
+  template<> struct LookupResult<void> {
+    void return_void() noexcept {}
+  };
+
+  /// @brief Coroutine task for interleaved lookups (async_get, async_exists and request handlers).
+  /// Lazily started, could be co_awaited from another Lookup, spawned to LookupScheduler or run synchronously by get()
+  template<typename T> class Lookup {
+    public :
+      struct promise_type : LookupResult<T> {
+        std::coroutine_handle<> continuation{};
+        std::exception_ptr error{};
+
+        static void* operator new(size_t size) {
+          return FramePool::allocate(size);
+        }
+        static void operator delete(void* ptr, size_t size) noexcept {
+          FramePool::deallocate(ptr, size);
+        }
+
+        Lookup get_return_object() noexcept {
+          return Lookup{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept {return {};}
+        auto final_suspend() noexcept {
+          //  Symmetric transfer back to awaiting coroutine if any
+          struct FinalAwaiter {
+            bool await_ready() noexcept {return false;}
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+              if (auto continuation {handle.promise().continuation}; continuation) {
+                return continuation;
+              }
+              return std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+          };
+          return FinalAwaiter{};
+        }
+        void unhandled_exception() noexcept {
+          error = std::current_exception();
+        }
+      };
+
+      explicit Lookup(std::coroutine_handle<promise_type> handle) noexcept : handle{handle} {}
+      ~Lookup() {
+        if (handle) {
+          handle.destroy();
+        }
+      }
+
+      Lookup(Lookup&) = delete;
+      Lookup(const Lookup&) = delete;
+      Lookup& operator = (Lookup&) = delete;
+      Lookup& operator = (const Lookup&) = delete;
+
+      /// @brief Move constructor
+      /// @param lookup Existing lookup
+      Lookup(Lookup&& lookup) noexcept : handle{std::exchange(lookup.handle, nullptr)} {}
+
+      /// @brief Move operator
+      /// @param lookup Existing lookup
+      /// @return Lookup
+      Lookup& operator = (Lookup&& lookup) noexcept {
+        if (this != &lookup) {
+          if (handle) {
+            handle.destroy();
+          }
+          handle = std::exchange(lookup.handle, nullptr);
+        }
+        return *this;
+      }
+
+      bool await_ready() const noexcept {return false;}
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() {
+        return result();
+      }
+
+      /// @brief Run lookup synchronously on current thread (probes are not interleaved)
+      /// @return Lookup result
+      T get() {
+        const auto scheduler {std::exchange(active_scheduler, nullptr)};
+        while (!handle.done()) {
+          handle.resume();
+        }
+        active_scheduler = scheduler;
+        return result();
+      }
+
+      /// @brief Check if lookup is finished
+      [[nodiscard]] bool done() const noexcept {return handle.done();}
+
+    private :
+      friend class LookupScheduler;
+
+      T result() {
+        if (handle.promise().error) {
+          std::rethrow_exception(handle.promise().error);
+        }
+        if constexpr (!std::is_void_v<T>) {
+          return std::move(handle.promise().result);
+        }
+      }
+
+      std::coroutine_handle<promise_type> handle;
+  };
+
+  /// @brief Round-robin scheduler for suspended lookups. Every lookup suspends after probe prefetch,
+  /// so other lookups run while probe cache line is loaded
+  class LookupScheduler {
+    public :
+      /// @brief Add lookup (usually request handler coroutine awaiting async_get) to scheduler
+      /// @param lookup Lookup task, owned by scheduler until run() end
+      void spawn(Lookup<void>&& lookup) {
+        schedule(lookup.handle);
+        spawned.push_back(std::move(lookup));
+      }
+
+      /// @brief Queue suspended coroutine to be resumed
+      /// @param handle Coroutine handle
+      void schedule(std::coroutine_handle<> handle) {
+        if (ready_number == ready.size()) {  //  Grow ring buffer keeping queue order
+          std::vector<std::coroutine_handle<>> grown(std::max<size_t>(ready.size() * 2, 16));
+          for (size_t count{0}; count < ready_number; ++count) {
+            grown[count] = ready[(ready_first + count) & (ready.size() - 1)];
+          }
+          ready = std::move(grown);
+          ready_first = 0;
+        }
+        ready[(ready_first + ready_number) & (ready.size() - 1)] = handle;
+        ++ready_number;
+      }
+
+      /// @brief Take first queued coroutine, queue should not be empty
+      /// @return Coroutine handle
+      std::coroutine_handle<> next() noexcept {
+        auto handle {ready[ready_first]};
+        ready_first = (ready_first + 1) & (ready.size() - 1);
+        --ready_number;
+        return handle;
+      }
+
+      /// @brief Resume suspended lookups round robin until all spawned ones are finished
+      /// @throw Exception from spawned lookup if any
+      void run() {
+        const auto scheduler {std::exchange(active_scheduler, this)};
+        while (ready_number) {
+          next().resume();
+        }
+        active_scheduler = scheduler;
+
+        auto finished {std::move(spawned)};
+        spawned.clear();
+        for (auto& lookup : finished) {
+          lookup.result();
+        }
+      }
+
+    private :
+      std::vector<std::coroutine_handle<>> ready;  ///  Ring buffer of resumable coroutines, power of 2 size
+      size_t ready_first {0};
+      size_t ready_number {0};
+      std::vector<Lookup<void>> spawned;
+  };
+
+  /// @brief Awaiter to prefetch probe location and give way to next lookup of active scheduler
+  struct Probe {
+    const void* addr;
+
+    bool await_ready() const noexcept {
+#if defined(__GNUC__)
+      __builtin_prefetch(addr);
+#endif
+      return active_scheduler == nullptr;
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle) const {
+      active_scheduler->schedule(handle);
+      return active_scheduler->next();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  /// Binary search levels checked without suspension, nodes of top levels are shared by all lookups
+  /// and are expected to stay in cache
+  inline constexpr unsigned default_hot_levels {8};
+
+  /// @brief Get element by key, interleaved with other lookups of LookupScheduler running on this thread
+  /// @param map HashMap to look in, should outlive lookup
+  /// @param key Key value (copied into coroutine frame)
+  /// @param hot_levels Binary search levels checked without suspension
+  /// @return Lookup task for Value pointer, nullptr if key is not found
+  template<typename Map> Lookup<const typename Map::mapped_type*> async_get(const Map& map, typename Map::key_type key, unsigned hot_levels = default_hot_levels) {
+    typename Map::template Search<typename Map::key_type> search{map, key};
+
+    while (!search.done()) {
+      if (search.level() >= hot_levels) {
+        co_await Probe{&search.probe()->hash};
+      }
+      search.step();
+    }
+    co_return search.node() ? &search.node()->val : nullptr;
+  }
+
+  /// @brief Check if element exists in map, interleaved with other lookups of LookupScheduler running on this thread
+  /// @param map HashMap to look in, should outlive lookup
+  /// @param key Key value (copied into coroutine frame)
+  /// @param hot_levels Binary search levels checked without suspension
+  /// @return Lookup task, true if exists, else false
+  template<typename Map> Lookup<bool> async_exists(const Map& map, typename Map::key_type key, unsigned hot_levels = default_hot_levels) {
+    co_return (co_await async_get(map, std::move(key), hot_levels)) != nullptr;
+  }
+}
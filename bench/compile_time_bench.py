@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#  Compile time cost of constexpr HashMap construction.
+#  Generates translation units with constexpr HashMap of requested sizes for int and std::string_view keys,
+#  compiles every one of them, records compilation time and peak compiler memory, prints table and writes JSON.
+#  Constexpr maps use Tools::SipHashFunction, std::hash based default policy could not be evaluated in compile time.
+
+import argparse
+import json
+import os
+import pathlib
+import platform
+import resource
+import secrets
+import shlex
+import signal
+import subprocess
+import sys
+import time
+
+#  Key type -> (C++ key type, key literal for entry number)
+KEY_TYPES = {
+    "int": ("int", lambda num: str((num * 2654435761) % 2147483647)),
+    "string_view": ("std::string_view", lambda num: f'"key_{num}"sv'),
+}
+
+#  Compiler diagnostics -> failure status
+FAILURES = (
+    ("operation count exceeds limit", "ops-limit"),
+    ("loop iteration count exceeds limit", "loop-limit"),
+    ("evaluation depth exceeds", "depth-limit"),
+    ("memory exhausted", "out-of-memory"),
+    ("out of memory", "out-of-memory"),
+    ("std::bad_alloc", "out-of-memory"),
+)
+
+
+def generate(path, key, size):
+    """Write translation unit with constexpr HashMap of `size` entries, size 0 is header only baseline."""
+    cpp_key, literal = KEY_TYPES[key]
+    lines = ['#include "libHashMap.hpp"', "", "#include <string_view>", "",
+             "using namespace std::literals;", "using namespace LibHashMap;", ""]
+    if size:
+        lines.append(f"static constexpr HashMap<{cpp_key}, int, uint32_t, {size}, "
+                     f"Tools::SipHashFunction<{cpp_key}, uint32_t>> map{{")
+        lines.append(",\n".join(f"  {{{literal(num)}, {num}}}" for num in range(size)))
+        lines.append("};")
+        lines.append(f"static_assert(map.exists({literal(size - 1)}));")
+        lines.append(f"int value({cpp_key} key) {{ return map.exists(key) ? *map.get(key) : -1; }}")
+    path.write_text("\n".join(lines) + "\n")
+
+
+def compile_tu(cmd, timeout, memory_limit_mb):
+    """Run compiler, return (status, seconds, peak memory MiB, diagnostic)."""
+
+    def limit_memory():
+        if memory_limit_mb:
+            limit = memory_limit_mb * 1024 * 1024
+            resource.setrlimit(resource.RLIMIT_AS, (limit, limit))
+
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                            preexec_fn=limit_memory, start_new_session=True)
+    stderr = []
+    os.set_blocking(proc.stderr.fileno(), False)
+    timed_out = False
+    while True:
+        #  wait4 reports usage of this compiler run only (driver and its waited children)
+        pid, wait_status, usage = os.wait4(proc.pid, os.WNOHANG)
+        chunk = proc.stderr.read()
+        if chunk:
+            stderr.append(chunk)
+        if pid:
+            break
+        if time.perf_counter() - start > timeout:
+            os.killpg(proc.pid, signal.SIGKILL)
+            timed_out = True
+        time.sleep(0.02)
+    seconds = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(wait_status)
+    chunk = proc.stderr.read()
+    if chunk:
+        stderr.append(chunk)
+    diagnostic = b"".join(stderr).decode(errors="replace")
+    #  ru_maxrss is in KiB on Linux and in bytes on macOS
+    peak_mb = usage.ru_maxrss / (1024 * 1024 if platform.system() == "Darwin" else 1024)
+
+    if timed_out:
+        return "timeout", seconds, peak_mb, ""
+    if proc.returncode == 0:
+        return "ok", seconds, peak_mb, ""
+    status = "error"
+    for marker, failure in FAILURES:
+        if marker in diagnostic:
+            status = failure
+            break
+    first_error = next((line for line in diagnostic.splitlines() if "error" in line), diagnostic.strip()[:200])
+    return status, seconds, peak_mb, first_error
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile time cost of constexpr HashMap")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "g++"), help="C++ compiler")
+    parser.add_argument("--include", required=True, help="libHashMap.hpp directory")
+    parser.add_argument("--out", default="compile_time", help="Directory for generated sources and results")
+    parser.add_argument("--sizes", default="100,250,500,1000,10000,50000", help="Comma separated map sizes")
+    parser.add_argument("--keys", default=",".join(KEY_TYPES), help="Comma separated key types")
+    parser.add_argument("--flags", default="-std=c++2b -O2", help="Compiler flags")
+    parser.add_argument("--constexpr-ops-limit", type=int, default=2147483647,
+                        help="-fconstexpr-ops-limit value (gcc), 0 keeps compiler default (2^25, about 100 entries)")
+    parser.add_argument("--build-seed", default=f"{secrets.randbits(64):#x},{secrets.randbits(64):#x}",
+                        help="LIBHASHMAP_BUILD_SEED_K0,LIBHASHMAP_BUILD_SEED_K1 for compile time SipHashFunction, "
+                             "random by default")
+    parser.add_argument("--timeout", type=float, default=600, help="Seconds per translation unit")
+    parser.add_argument("--memory-limit-mb", type=int, default=8192,
+                        help="Compiler address space limit, compiler running out of it is reported as out-of-memory, "
+                             "0 - no limit")
+    args = parser.parse_args()
+
+    out = pathlib.Path(args.out)
+    out.mkdir(parents=True, exist_ok=True)
+    seed_k0, seed_k1 = args.build_seed.split(",")
+    #  Secret is passed to compiler only, it is not written to results
+    seed_flags = [f"-DLIBHASHMAP_BUILD_SEED_K0={seed_k0}ULL", f"-DLIBHASHMAP_BUILD_SEED_K1={seed_k1}ULL"]
+    flags = shlex.split(args.flags)
+    if args.constexpr_ops_limit:
+        flags.append(f"-fconstexpr-ops-limit={args.constexpr_ops_limit}")
+    sizes = [0] + [int(size) for size in args.sizes.split(",") if size]
+    keys = [key for key in args.keys.split(",") if key]
+
+    results = []
+    print(f"{'key':<12} {'entries':>8} {'status':<14} {'seconds':>9} {'peak MiB':>9}")
+    for key in keys:
+        for size in sizes:
+            src = out / f"hashmap_{key}_{size}.cpp"
+            generate(src, key, size)
+            cmd = [args.cxx, *flags, *seed_flags, "-I", args.include, "-c", str(src), "-o", str(src.with_suffix(".o"))]
+            status, seconds, peak_mb, diagnostic = compile_tu(cmd, args.timeout, args.memory_limit_mb)
+            results.append({"key": key, "entries": size, "status": status, "seconds": round(seconds, 3),
+                            "peak_mb": round(peak_mb, 1), "diagnostic": diagnostic})
+            print(f"{key:<12} {size if size else 'header':>8} {status:<14} {seconds:>9.2f} {peak_mb:>9.1f}", flush=True)
+
+    report = {"compiler": args.cxx, "flags": flags, "timeout": args.timeout,
+              "memory_limit_mb": args.memory_limit_mb, "results": results}
+    (out / "results.json").write_text(json.dumps(report, indent=2) + "\n")
+    print(f"Results: {out / 'results.json'}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,85 @@
+//  Hash function policies overhead: std::hash based HashFunction vs keyed SipHashFunction
+//  Raw hash counting and HashMap::get() cost for int and short string keys
+
+#include "../src/libHashMap.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace LibHashMap;
+using namespace LibHashMap::Tools;
+
+constexpr size_t map_size {1024};
+constexpr size_t rounds {2'000'000};
+
+/// @brief Run function and count time per operation
+/// @param ops Operations number
+/// @param func Benchmark body
+/// @return Nanoseconds per operation
+template<typename Func> double nsPerOp(size_t ops, Func&& func) {
+  const auto start {std::chrono::steady_clock::now()};
+  func();
+  const std::chrono::duration<double, std::nano> elapsed {std::chrono::steady_clock::now() - start};
+  return elapsed.count() / ops;
+}
+
+/// @brief Create HashMap on heap by runtime keys (HashMap could be created by initializer list only)
+template<typename Map, size_t... I> std::unique_ptr<Map> makeMap(const std::vector<typename Map::key_type>& keys, std::index_sequence<I...>) {
+  return std::make_unique<Map>(std::initializer_list<std::pair<typename Map::key_type, typename Map::mapped_type>>{{keys[I], static_cast<typename Map::mapped_type>(I)}...});
+}
+
+template<typename Hash, typename Key> double hashCost(const std::vector<Key>& keys) {
+  Hash hash{};
+  size_t sink {0};
+  const auto res {nsPerOp(rounds, [&] {
+    for (size_t count{0}; count < rounds; ++count) {
+      sink += hash(keys[count % keys.size()]);
+    }
+  })};
+  volatile size_t keep {sink};
+  (void)keep;
+  return res;
+}
+
+template<typename Map> double getCost(const std::vector<typename Map::key_type>& keys) {
+  const auto map {makeMap<Map>(keys, std::make_index_sequence<map_size>{})};
+  size_t sink {0};
+  const auto res {nsPerOp(rounds, [&] {
+    for (size_t count{0}; count < rounds; ++count) {
+      sink += *map->get(keys[(count * 7) % keys.size()]);
+    }
+  })};
+  volatile size_t keep {sink};
+  (void)keep;
+  return res;
+}
+
+void report(const char* name, double std_hash, double sip_hash) {
+  std::printf("%-28s %12.2f %12.2f %9.2fx\n", name, std_hash, sip_hash, sip_hash / std_hash);
+}
+
+int main() {
+  std::vector<size_t> int_keys;
+  std::vector<std::string> short_keys, long_keys;
+  for (size_t count{0}; count < map_size; ++count) {
+    int_keys.push_back(count * 2654435761u);
+    short_keys.push_back("key" + std::to_string(count));
+    long_keys.push_back("user:session:" + std::to_string(count) + ":profile");
+  }
+
+  std::printf("%-28s %12s %12s %10s\n", "ns/op", "HashFunction", "SipHash-1-3", "overhead");
+  report("hash size_t", hashCost<HashFunction<size_t>>(int_keys), hashCost<SipHashFunction<size_t>>(int_keys));
+  report("hash string (<= 7 bytes)", hashCost<HashFunction<std::string>>(short_keys), hashCost<SipHashFunction<std::string>>(short_keys));
+  report("hash string (~25 bytes)", hashCost<HashFunction<std::string>>(long_keys), hashCost<SipHashFunction<std::string>>(long_keys));
+  report("get() size_t",
+         getCost<HashMap<size_t, size_t, size_t, map_size>>(int_keys),
+         getCost<HashMap<size_t, size_t, size_t, map_size, SipHashFunction<size_t>>>(int_keys));
+  report("get() string (<= 7 bytes)",
+         getCost<HashMap<std::string, size_t, size_t, map_size>>(short_keys),
+         getCost<HashMap<std::string, size_t, size_t, map_size, SipHashFunction<std::string>>>(short_keys));
+  return 0;
+}
@@ -0,0 +1,30 @@
+# Secret seed for compile time created maps with SipHashFunction.
+# Two independent 64 bit halves (LIBHASHMAP_BUILD_SEED_K0, LIBHASHMAP_BUILD_SEED_K1) are taken from OS CSPRNG
+# once per build tree and kept in cache. Installed package calls it in consumer build tree, so the secret is
+# never written to exported targets
+
+function(libhashmap_generate_build_seed)
+  if (LIBHASHMAP_BUILD_SEED_K0 AND LIBHASHMAP_BUILD_SEED_K1)
+    return()
+  endif (LIBHASHMAP_BUILD_SEED_K0 AND LIBHASHMAP_BUILD_SEED_K1)
+  if (LIBHASHMAP_BUILD_SEED_K0 OR LIBHASHMAP_BUILD_SEED_K1)
+    message(FATAL_ERROR "Both LIBHASHMAP_BUILD_SEED_K0 and LIBHASHMAP_BUILD_SEED_K1 should be set")
+  endif (LIBHASHMAP_BUILD_SEED_K0 OR LIBHASHMAP_BUILD_SEED_K1)
+  if (EXISTS /dev/urandom)
+    file(READ /dev/urandom seed_hex LIMIT 16 HEX)
+  else (EXISTS /dev/urandom)
+    find_package(Python3 COMPONENTS Interpreter)
+    if (Python3_FOUND)
+      execute_process(COMMAND ${Python3_EXECUTABLE} -c "import secrets; print(secrets.token_hex(16))"
+                      OUTPUT_VARIABLE seed_hex OUTPUT_STRIP_TRAILING_WHITESPACE)
+    endif (Python3_FOUND)
+  endif (EXISTS /dev/urandom)
+  string(LENGTH "${seed_hex}" seed_length)
+  if (NOT seed_length EQUAL 32)
+    message(FATAL_ERROR "No random source for LibHashMap build seed, set LIBHASHMAP_BUILD_SEED_K0 and LIBHASHMAP_BUILD_SEED_K1 (64 bit hex, e.g. 0x0123456789abcdef)")
+  endif (NOT seed_length EQUAL 32)
+  string(SUBSTRING "${seed_hex}" 0 16 seed_k0)
+  string(SUBSTRING "${seed_hex}" 16 16 seed_k1)
+  set(LIBHASHMAP_BUILD_SEED_K0 "0x${seed_k0}" CACHE STRING "First half of compile time SipHashFunction secret (64 bit)")
+  set(LIBHASHMAP_BUILD_SEED_K1 "0x${seed_k1}" CACHE STRING "Second half of compile time SipHashFunction secret (64 bit)")
+endfunction(libhashmap_generate_build_seed)
@@ -45,12 +45,20 @@ SOFTWARE.
  *
  */
 
+#pragma once
+
 #include <array>
 #include <functional>
 #include <cstdint>
 #include <algorithm>
 #include <concepts>
 #include <type_traits>
+#include <cassert>
+#include <bit>
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <utility>
 
 
 /*std::unsigned_integral*/
@@ -179,7 +187,7 @@ namespace LibHashMap {
       /// @brief Move operator
       /// @param node Existing node structure
       /// @return Node structure
-      Node& operator = (Node&& node) noexcept {
+      constexpr Node& operator = (Node&& node) noexcept {
         key = std::move(node.key);
         val = std::move(node.val);
         hash = std::move(node.hash);
@@ -215,7 +223,7 @@ namespace LibHashMap {
         /// @brief Counting hash with defined type HahsType for KeyType value type
         /// @param val KeyType (&, &&) value
         /// @return HashType (&) value
-        [[nodiscard]] constexpr auto countHash(auto&& val) noexcept {
+        [[nodiscard]] constexpr auto countHash(auto&& val) const noexcept {
           auto hash {std_hash_counter(std::forward<decltype(val)>(val))};
           if constexpr (std::is_same<HashType, size_t>::value) {
             return hash;
@@ -226,7 +234,7 @@ namespace LibHashMap {
         /// @brief Operator to count hash with defined type HahsType for KeyType value type
         /// @param val KeyType (&, &&) value
         /// @return HashType (&) value
-        constexpr auto operator()(auto&& val) noexcept {
+        constexpr auto operator()(auto&& val) const noexcept {
           auto hash {std_hash_counter(std::forward<decltype(val)>(val))};
           if constexpr (std::is_same<HashType, size_t>::value) {
             return hash;
@@ -235,27 +243,188 @@ namespace LibHashMap {
           }
         }
     };
+
+    /// Secret for SipHashFunction objects created in compile time, two independent 64 bit halves set by
+    /// LIBHASHMAP_BUILD_SEED_K0 and LIBHASHMAP_BUILD_SEED_K1 definitions. libHashMap CMake target generates them once
+    /// per build tree, other builds should define the same random values for all translation units.
+    /// Without them SipHashFunction could be created in run time only
+#if defined(LIBHASHMAP_BUILD_SEED_K0) && defined(LIBHASHMAP_BUILD_SEED_K1)
+    inline constexpr std::pair<uint64_t, uint64_t> build_seed {static_cast<uint64_t>(LIBHASHMAP_BUILD_SEED_K0), static_cast<uint64_t>(LIBHASHMAP_BUILD_SEED_K1)};
+#elif defined(LIBHASHMAP_BUILD_SEED_K0) || defined(LIBHASHMAP_BUILD_SEED_K1)
+#error "Both LIBHASHMAP_BUILD_SEED_K0 and LIBHASHMAP_BUILD_SEED_K1 should be defined"
+#else
+    /// Not constexpr on purpose - compile time SipHashFunction creation fails here if there is no build seed
+    inline void buildSeedIsNotDefined() noexcept {}
+#endif
+
+    /// @brief Keyed hash function object (SipHash-c-d, SipHash-1-3 by default) to resist hash flooding by crafted keys.
+    /// Secret is random for every object created in run time and build_seed for object created in compile time.
+    /// Key type should be string like (convertible to std::string_view), integral, enum or trivially copyable
+    template<typename KeyType, std::unsigned_integral HashType = size_t, unsigned c_rounds = 1, unsigned d_rounds = 3> class SipHashFunction {
+      private :
+        uint64_t k0 {0}, k1 {0};
+
+        static constexpr void sipRound(std::array<uint64_t, 4>& v) noexcept {
+          v[0] += v[1]; v[1] = std::rotl(v[1], 13); v[1] ^= v[0]; v[0] = std::rotl(v[0], 32);
+          v[2] += v[3]; v[3] = std::rotl(v[3], 16); v[3] ^= v[2];
+          v[0] += v[3]; v[3] = std::rotl(v[3], 21); v[3] ^= v[0];
+          v[2] += v[1]; v[1] = std::rotl(v[1], 17); v[1] ^= v[2]; v[2] = std::rotl(v[2], 32);
+        }
+
+        /// Little endian word load, memcpy in run time and byte by byte in compile time
+        static constexpr uint64_t load64(const std::string_view& bytes, size_t pos, size_t len) noexcept {
+          uint64_t word {0};
+          if (std::is_constant_evaluated() || len < sizeof(word)) {
+            for (size_t count{0}; count < len; ++count) {
+              word |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[pos + count])) << (8 * count);
+            }
+          } else {
+            std::memcpy(&word, bytes.data() + pos, sizeof(word));
+            if constexpr (std::endian::native == std::endian::big) {
+              word = std::byteswap(word);
+            }
+          }
+          return word;
+        }
+
+        constexpr std::array<uint64_t, 4> sipInit() const noexcept {
+          return {k0 ^ 0x736f6d6570736575, k1 ^ 0x646f72616e646f6d, k0 ^ 0x6c7967656e657261, k1 ^ 0x7465646279746573};
+        }
+
+        static constexpr void sipCompress(std::array<uint64_t, 4>& v, uint64_t word) noexcept {
+          v[3] ^= word;
+          for (unsigned count{0}; count < c_rounds; ++count) {
+            sipRound(v);
+          }
+          v[0] ^= word;
+        }
+
+        static constexpr uint64_t sipFinalize(std::array<uint64_t, 4>& v) noexcept {
+          v[2] ^= 0xff;
+          for (unsigned count{0}; count < d_rounds; ++count) {
+            sipRound(v);
+          }
+          return v[0] ^ v[1] ^ v[2] ^ v[3];
+        }
+
+        constexpr uint64_t sipHash(const std::string_view& bytes) const noexcept {
+          auto v {sipInit()};
+          const size_t tail {bytes.size() & ~size_t{7}};
+
+          for (size_t pos{0}; pos < tail; pos += 8) {
+            sipCompress(v, load64(bytes, pos, 8));
+          }
+          sipCompress(v, load64(bytes, tail, bytes.size() - tail) | (static_cast<uint64_t>(bytes.size()) << 56));
+          return sipFinalize(v);
+        }
+
+        /// The same result as sipHash of little endian bytes of up to 8 bytes long value, without bytes copying
+        constexpr uint64_t sipHashWord(uint64_t word, size_t len) const noexcept {
+          auto v {sipInit()};
+
+          if (len == sizeof(word)) {
+            sipCompress(v, word);
+            sipCompress(v, static_cast<uint64_t>(len) << 56);
+          } else {
+            sipCompress(v, word | (static_cast<uint64_t>(len) << 56));
+          }
+          return sipFinalize(v);
+        }
+
+        constexpr uint64_t hashValue(const auto& val) const noexcept {
+          using ValType = std::remove_cvref_t<decltype(val)>;
+          if constexpr (std::is_convertible_v<const ValType&, std::string_view>) {
+            return sipHash(std::string_view{val});
+          } else if constexpr ((std::is_integral_v<ValType> || std::is_enum_v<ValType>) && sizeof(ValType) <= sizeof(uint64_t)) {  //  Fixed byte order, the same hash in compile and run time
+            auto raw {static_cast<uint64_t>(val)};
+            if constexpr (sizeof(ValType) < sizeof(uint64_t)) {
+              raw &= (uint64_t{1} << (8 * sizeof(ValType))) - 1;
+            }
+            return sipHashWord(raw, sizeof(ValType));
+          } else {
+            static_assert(std::is_trivially_copyable_v<ValType>, "Key type should be string like, integral or trivially copyable");
+            const auto bytes {std::bit_cast<std::array<char, sizeof(ValType)>>(val)};
+            return sipHash(std::string_view{bytes.data(), bytes.size()});
+          }
+        }
+
+        /// Value is converted to KeyType (string like one is viewed as std::string_view) before hashing,
+        /// so lookup by key of another type gets the same hash as stored key
+        constexpr uint64_t keyHash(const auto& val) const noexcept {
+          using ValType = std::remove_cvref_t<decltype(val)>;
+          if constexpr (std::is_convertible_v<const KeyType&, std::string_view> && std::is_convertible_v<const ValType&, std::string_view>) {
+            return hashValue(std::string_view{val});
+          } else {
+            return hashValue(static_cast<const KeyType&>(val));
+          }
+        }
+
+      public :
+        /// @brief Default constructor, random secret in run time or build seed based one in compile time
+        constexpr SipHashFunction() {
+          if (std::is_constant_evaluated()) {
+#if defined(LIBHASHMAP_BUILD_SEED_K0) && defined(LIBHASHMAP_BUILD_SEED_K1)
+            k0 = build_seed.first;
+            k1 = build_seed.second;
+#else
+            buildSeedIsNotDefined();
+#endif
+          } else {
+            std::random_device rnd;
+            k0 = (static_cast<uint64_t>(rnd()) << 32) | rnd();
+            k1 = (static_cast<uint64_t>(rnd()) << 32) | rnd();
+          }
+        }
+
+        /// @brief Constructor with explicitly defined secret
+        /// @param k0 First secret half
+        /// @param k1 Second secret half
+        constexpr SipHashFunction(uint64_t k0, uint64_t k1) noexcept : k0{k0}, k1{k1} {}
+
+        /// @brief Secret used by object
+        /// @return Pair of secret halves
+        [[nodiscard]] constexpr std::pair<uint64_t, uint64_t> seed() const noexcept {
+          return {k0, k1};
+        }
+
+        /// @brief Counting keyed hash with defined type HahsType for KeyType value type
+        /// @param val KeyType (&, &&) value
+        /// @return HashType (&) value
+        [[nodiscard]] constexpr auto countHash(auto&& val) const noexcept {
+          return static_cast<HashType>(keyHash(val));
+        }
+        /// @brief Operator to count keyed hash with defined type HahsType for KeyType value type
+        /// @param val KeyType (&, &&) value
+        /// @return HashType (&) value
+        constexpr auto operator()(auto&& val) const noexcept {
+          return static_cast<HashType>(keyHash(val));
+        }
+    };
   }  
 
   /// @brief Class HashMap  Version 0.0.1
   /// HashMap - Interface for data storing
-  template<typename Key, typename Value, std::unsigned_integral Size = size_t, Size dim_size = 0>
-  class HashMap : Tools::HashFunction<Key, Size> {
+  /// Hash - hash function object policy, Tools::HashFunction (std::hash based) by default,
+  /// Tools::SipHashFunction for keys from untrusted sources
+  template<typename Key, typename Value, std::unsigned_integral Size = size_t, Size dim_size = 0, typename Hash = Tools::HashFunction<Key, Size>>
+  class HashMap : Hash {
     public :
+      using key_type = Key;
+      using mapped_type = Value;
 
       /// @brief Constructor to create HashMap class by initializer list
       /// @param lst initializer list
       constexpr explicit HashMap (const std::initializer_list<std::pair<Key, Value>>& lst)
-      : Tools::HashFunction<Key, Size>() {
+      : Hash() {
         Size tmp_hash_sz{0}, stor_sz{0};
         std::array<Size, dim_size> tmp_hash_tbl;
         std::array<Key, dim_size> tmp_key_tbl;
 
         //  Creating new hash for key if key value is not duplicated
         auto countHash = [this, &tmp_hash_tbl, &tmp_hash_sz, &tmp_key_tbl, &stor_sz](auto val) {
-          auto hash {Tools::HashFunction<Key, Size>::countHash(std::forward<Key>(val.first))};
+          auto hash {Hash::countHash(std::forward<Key>(val.first))};
 
-          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl, hash)}; it_collision_node == tmp_hash_tbl.end()) { //  Just add new data node (no value duplication or cash collision case)
+          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl.begin(), tmp_hash_tbl.begin() + tmp_hash_sz, hash)}; it_collision_node == tmp_hash_tbl.begin() + tmp_hash_sz) { //  Just add new data node (no value duplication or cash collision case)
             tmp_hash_tbl[tmp_hash_sz] = hash;
             tmp_key_tbl[tmp_hash_sz] = val.first;
             Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
@@ -263,7 +432,7 @@ namespace LibHashMap {
             ++tmp_hash_sz;
             ++stor_sz;
           } else {
-            if (std::ranges::find(tmp_key_tbl, val.first) == tmp_key_tbl.end()) {  //  Hash collision case
+            if (std::ranges::find(tmp_key_tbl.begin(), tmp_key_tbl.begin() + tmp_hash_sz, val.first) == tmp_key_tbl.begin() + tmp_hash_sz) {  //  Hash collision case
               Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
               data_stor[pivot_number] = std::move(node);
               auto collision_node {std::ranges::find_if(data_stor.begin(), data_stor.begin() + (dim_size - (dim_size - pivot_number)), [&hash] (const auto& stor_node){return stor_node.hash == hash;})};
@@ -284,16 +453,16 @@ namespace LibHashMap {
       /// @brief Move constructor to create HashMap class by initializer list
       /// @param lst initializer list
       constexpr explicit HashMap (std::initializer_list<std::pair<Key, Value>>&& lst) 
-      : Tools::HashFunction<Key, Size>() {
+      : Hash() {
         Size tmp_hash_sz{0}, stor_sz{0};
         std::array<Size, dim_size> tmp_hash_tbl;
         std::array<Key, dim_size> tmp_key_tbl;
 
         //  Creating new hash for key if key value is not duplicated
         auto countHash = [this, &tmp_hash_tbl, &tmp_hash_sz, &tmp_key_tbl, &stor_sz](auto val) {
-          auto hash {Tools::HashFunction<Key, Size>::countHash(std::forward<Key>(val.first))};
+          auto hash {Hash::countHash(std::forward<Key>(val.first))};
 
-          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl, hash)}; it_collision_node == tmp_hash_tbl.end()) { //  Just add new data node (no value duplication or cash collision case)
+          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl.begin(), tmp_hash_tbl.begin() + tmp_hash_sz, hash)}; it_collision_node == tmp_hash_tbl.begin() + tmp_hash_sz) { //  Just add new data node (no value duplication or cash collision case)
             tmp_hash_tbl[tmp_hash_sz] = hash;
             tmp_key_tbl[tmp_hash_sz] = val.first;
             Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
@@ -301,7 +470,7 @@ namespace LibHashMap {
             ++tmp_hash_sz;
             ++stor_sz;
           } else {
-            if (std::ranges::find(tmp_key_tbl, val.first) == tmp_key_tbl.end()) {  //  Hash collision case
+            if (std::ranges::find(tmp_key_tbl.begin(), tmp_key_tbl.begin() + tmp_hash_sz, val.first) == tmp_key_tbl.begin() + tmp_hash_sz) {  //  Hash collision case
               Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
               data_stor[pivot_number] = std::move(node);
               auto collision_node {std::ranges::find_if(data_stor.begin(), data_stor.begin() + (dim_size - (dim_size - pivot_number)), [&hash] (const auto& stor_node){return stor_node.hash == hash;})};
@@ -329,52 +498,12 @@ namespace LibHashMap {
       /// @brief Get element by key
       /// @param key KeyType (&, &&) value
       /// @return Value (&) value
-      constexpr auto get(auto&& key) noexcept {
+      constexpr auto get(auto&& key) const noexcept {
         const Value* val{nullptr};
-        Size pos{(Size)floor(pivot_number / 2)};
-        const Tools::Node<Key, Value, Size, dim_size>* array_val;
-        const auto key_hash {Tools::HashFunction<Key, Size>::countHash(std::forward<Key>(key))};
-
-        do {
-          array_val =&data_stor[pos];
-          auto res {array_val->hash <=> key_hash};
-
-          if (res == 0) {
-            if (array_val->collisions_number) {
-              if (array_val->key == key) {  //  There are collisions but first value is in main collision node
-                val = &(array_val->val);
-              } else {
-                for (auto count : array_val->collision_chain) {  //  Looking value in collision chain
-                  if (key == count->key) {
-                    val = &count->val;
-                    break;
-                  }
-                }
-              }
-            } else {  //  There are no collisions at all
-              val = &array_val->val;  
-            }
-            break;
-          }
-          if (res > 0) {
-            if (pos == 0) {
-              break;
-            }
-            if (pos == 1) {
-              --pos;
-            } else {
-              pos -= pos/2; 
-            }
-          }
-          if (res < 0) {
-            if (pos == 1) {
-              ++pos;
-            } else {
-              pos += pos/2; 
-            }
-          }
-        } while (pos >= 0 && pos <= pivot_number); 
-        
+
+        if (auto array_val {findNode(key)}; array_val) {
+          val = &array_val->val;
+        }
         return val;
       }
       
@@ -382,58 +511,93 @@ namespace LibHashMap {
       /// @brief Check if element exists in map
       /// @param key KeyType (&, &&) value
       /// @return true if exists, else false
-      constexpr bool exists(auto&& key) noexcept {
-        bool ret {false};
-        Size pos{(Size)floor(pivot_number / 2)};
-        const Tools::Node<Key, Value, Size, dim_size>* array_val;
-        const auto key_hash {Tools::HashFunction<Key, Size>::countHash(std::forward<Key>(key))};
-        
-        do {
-          array_val = &data_stor[pos];
-          auto res {array_val->hash <=> key_hash};
-
-          if (res == 0) {
-            if (array_val->collisions_number) {
-              if (array_val->key == key) {  //  There are collisions but first value is in main collision node
-                ret = true;
-                break;
-              } else {
-                for (auto count : array_val->collision_chain) {  //  Looking value in collision chain
-                  if (key == count->key) {
-                    ret = true;
-                    break;
-                  }
-                }
-              }
-            } else {  //  There are no collisions at all
-              ret = true;
-              break;  
-            }
-            ret = true;
-            break;
+      constexpr bool exists(auto&& key) const noexcept {
+        return findNode(key) != nullptr;
+      }
+      
+      /// @brief Step by step lookup: binary search by key hash over sorted part of storage, then collision chain check.
+      /// Shared by get(), exists() and interleaved lookups of bench/async_lookup.hpp, map and key should outlive it
+      template<typename LookupKey = Key> class Search {
+        public :
+          /// @brief Start lookup
+          /// @param map HashMap to look in
+          /// @param key Key value
+          constexpr Search(const HashMap& map, const LookupKey& key) noexcept
+          : map{map}, key{static_cast<CompareKey>(key)}, key_hash{static_cast<Size>(map.Hash::countHash(key))}, high{static_cast<Size>(map.pivot_number + 1)} {}
+
+          /// @brief Check if lookup is finished
+          [[nodiscard]] constexpr bool done() const noexcept {return low >= high;}
+          /// @brief Node to be checked by next step (valid if lookup is not finished)
+          [[nodiscard]] constexpr const Tools::Node<Key, Value, Size, dim_size>* probe() const noexcept {
+            return &map.data_stor[low + (high - low) / 2];
           }
-          if (res > 0) {
-            if (pos == 0) {
-              break;
-            }
-            if (pos == 1) {
-              --pos;
+          /// @brief Number of steps made, binary search tree level of next probe
+          [[nodiscard]] constexpr unsigned level() const noexcept {return steps;}
+          /// @brief Found node or nullptr
+          [[nodiscard]] constexpr const Tools::Node<Key, Value, Size, dim_size>* node() const noexcept {return found;}
+
+          /// @brief Check next node and narrow search range
+          constexpr void step() noexcept {
+            const Size pos {static_cast<Size>(low + (high - low) / 2)};
+            const Tools::Node<Key, Value, Size, dim_size>* array_val {&map.data_stor[pos]};
+            auto res {array_val->hash <=> key_hash};
+
+            ++steps;
+            if (res == 0) {
+              found = matchNode(array_val, key);
+              low = high;
+            } else if (res > 0) {
+              high = pos;
             } else {
-              pos -= pos/2; 
+              low = pos + 1;
             }
           }
-          if (res < 0) {
-            if (pos == 1) {
-              ++pos;
-            } else {
-              pos += pos/2; 
+
+        private :
+          /// Lookup key is compared as is if it is KeyType or both are string like, else it is converted to KeyType once,
+          /// the same way SipHashFunction hashes it
+          using CompareKey = std::conditional_t<std::is_same_v<LookupKey, Key> ||
+                                                (std::is_convertible_v<const Key&, std::string_view> && std::is_convertible_v<const LookupKey&, std::string_view>),
+                                                const LookupKey&, Key>;
+
+          const HashMap& map;
+          CompareKey key;
+          Size key_hash;
+          Size low {0};
+          Size high;
+          unsigned steps {0};
+          const Tools::Node<Key, Value, Size, dim_size>* found {nullptr};
+      };
+
+      private :
+        /// @brief Look for key in node with equal hash and its collision chain
+        /// @param array_val Node with key hash
+        /// @param key KeyType (&) value
+        /// @return Pointer to node with requested key or nullptr
+        static constexpr const Tools::Node<Key, Value, Size, dim_size>* matchNode(const Tools::Node<Key, Value, Size, dim_size>* array_val, const auto& key) noexcept {
+          if (array_val->key == key) {  //  No collisions or value is in main collision node
+            return array_val;
+          }
+          for (Size count{0}; count < array_val->collisions_number; ++count) {  //  Looking value in collision chain
+            if (key == array_val->collision_chain[count]->key) {
+              return array_val->collision_chain[count];
             }
           }
-        } while (pos >= 0 && pos <= pivot_number); 
-        return ret;
-      }
-      
-      private :
+          return nullptr;
+        }
+
+        /// @brief Synchronous lookup
+        /// @param key KeyType (&) value
+        /// @return Pointer to node with requested key or nullptr
+        constexpr const Tools::Node<Key, Value, Size, dim_size>* findNode(const auto& key) const noexcept {
+          Search<std::remove_cvref_t<decltype(key)>> search{*this, key};
+
+          while (!search.done()) {
+            search.step();
+          }
+          return search.node();
+        }
+
         Size pivot_number {dim_size - 1};
         std::array<Tools::Node<Key, Value, Size, dim_size>, dim_size> data_stor{};
   };
@@ -0,0 +1,401 @@
+/*
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+SPDX-License-Identifier: MIT
+Copyright (c) 2022 Andrey Fokin lazzyfox@gmail.com.
+Permission is hereby  granted, free of charge, to any  person obtaining a copy
+of this software and associated  documentation files (the "Software"), to deal
+in the Software  without restriction, including without  limitation the rights
+to  use, copy,  modify, merge,  publish, distribute,  sublicense, and/or  sell
+copies  of  the Software,  and  to  permit persons  to  whom  the Software  is
+furnished to do so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*! \page placement_page Runtime placement of large maps
+ *
+ *  Optional add-on for HashMap objects built at runtime (not constexpr).
+ *  Map storage could be backed by 2 MiB huge pages (MAP_HUGETLB, then
+ *  madvise(MADV_HUGEPAGE), then regular pages as fallback) and replicated
+ *  per NUMA node, so every lookup thread reads local memory.
+ *  Replica mode could simulate several nodes on single node box.
+ *  Huge pages and NUMA binding are Linux only, other systems get regular memory.
+ */
+
+#pragma once
+
+#include "libHashMap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <initializer_list>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace LibHashMap {
+
+  /// @brief  HashMap memory placement namespace
+  namespace Placement {
+
+    /// @brief Pages kind backing map storage
+    enum class Pages : uint8_t {
+      Regular,      ///  Default system pages
+      Transparent,  ///  Transparent huge pages, requested by madvise
+      Huge          ///  Explicit huge pages, MAP_HUGETLB
+    };
+
+    /// Huge page size used for storage size rounding and alignment
+    inline constexpr size_t huge_page_size {2 * 1024 * 1024};
+
+    /// @brief Placement tools namespace
+    namespace Tools {
+
+      /// @brief Parse kernel CPU list format ("0-3,8,10-11")
+      /// @param cpu_list CPU list string
+      /// @return CPU numbers
+      inline std::vector<unsigned> parseCpuList(const std::string& cpu_list) {
+        std::vector<unsigned> cpus;
+        size_t pos {0};
+
+        while (pos < cpu_list.size()) {
+          auto end {cpu_list.find(',', pos)};
+          if (end == std::string::npos) {
+            end = cpu_list.size();
+          }
+          const auto range {cpu_list.substr(pos, end - pos)};
+          if (!range.empty() && range.front() != '\n') {
+            const auto dash {range.find('-')};
+            const unsigned first {static_cast<unsigned>(std::stoul(range.substr(0, dash)))};
+            const unsigned last {dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)))};
+            for (auto cpu {first}; cpu <= last; ++cpu) {
+              cpus.push_back(cpu);
+            }
+          }
+          pos = end + 1;
+        }
+        return cpus;
+      }
+
+      /// @brief CPU to NUMA node table, read from sysfs
+      /// @return Node number for every CPU index (empty if topology is unknown)
+      inline std::vector<unsigned> cpuNodes() {
+        std::vector<unsigned> cpu_nodes;
+#if defined(__linux__)
+        std::error_code err;
+        for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", err)) {
+          const auto name {entry.path().filename().string()};
+          if (name.size() < 5 || name.compare(0, 4, "node") || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+          }
+          const unsigned node {static_cast<unsigned>(std::stoul(name.substr(4)))};
+          std::ifstream cpu_list_file {entry.path() / "cpulist"};
+          std::string cpu_list;
+          std::getline(cpu_list_file, cpu_list);
+          for (auto cpu : parseCpuList(cpu_list)) {
+            if (cpu >= cpu_nodes.size()) {
+              cpu_nodes.resize(cpu + 1, 0);
+            }
+            cpu_nodes[cpu] = node;
+          }
+        }
+#endif
+        return cpu_nodes;
+      }
+
+      /// @brief Number of NUMA nodes with CPUs
+      /// @param cpu_nodes CPU to node table
+      /// @return Nodes number (at least 1)
+      inline unsigned nodesNumber(const std::vector<unsigned>& cpu_nodes) noexcept {
+        unsigned nodes {1};
+        for (auto node : cpu_nodes) {
+          nodes = std::max(nodes, node + 1);
+        }
+        return nodes;
+      }
+
+      /// @brief CPU current thread is running on
+      /// @return CPU number or 0 if unknown
+      inline unsigned currentCpu() noexcept {
+#if defined(__linux__)
+        if (const auto cpu {sched_getcpu()}; cpu >= 0) {
+          return static_cast<unsigned>(cpu);
+        }
+#endif
+        return 0;
+      }
+
+      /// @brief Set preferred NUMA node for memory range, should be called before first page touch
+      /// Uses mbind system call directly, no libnuma dependency. Error is not critical - memory stays on default node
+      /// @param addr Memory range start
+      /// @param size Memory range size
+      /// @param node NUMA node
+      /// @return true if policy was set, else false
+      inline bool bindToNode([[maybe_unused]] void* addr, [[maybe_unused]] size_t size, [[maybe_unused]] unsigned node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+        constexpr int mpol_preferred {1};
+        if (node >= sizeof(unsigned long) * 8) {
+          return false;
+        }
+        const unsigned long node_mask {1UL << node};
+        return !syscall(SYS_mbind, addr, size, mpol_preferred, &node_mask, sizeof(node_mask) * 8 + 1, 0);
+#else
+        return false;
+#endif
+      }
+    }
+
+    /// @brief Raw memory region for map storage, backed by requested pages kind when possible
+    class Region {
+      public :
+        /// @brief Allocate memory region
+        /// Huge pages request falls back to transparent huge pages, then to regular pages
+        /// @param bytes Requested size
+        /// @param pages Requested pages kind
+        /// @param node NUMA node to place memory on, negative value for default system policy
+        /// @throw std::bad_alloc if memory could not be allocated at all
+        explicit Region(size_t bytes, Pages pages = Pages::Huge, int node = -1) {
+#if defined(__linux__)
+          const auto page_size {static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+          const auto round_up = [](size_t val, size_t align) {return (val + align - 1) / align * align;};
+
+          if (pages == Pages::Huge) {
+            size = round_up(bytes, huge_page_size);
+            if (auto addr {mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0)}; addr != MAP_FAILED) {
+              data_ptr = addr;
+              pages_kind = Pages::Huge;
+            } else {
+              pages = Pages::Transparent;
+            }
+          }
+          if (pages == Pages::Transparent) {  //  Over-allocate to align region on huge page boundary
+            size = round_up(bytes, huge_page_size);
+            if (auto addr {mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)}; addr != MAP_FAILED) {
+              const auto raw {reinterpret_cast<uintptr_t>(addr)};
+              const auto aligned {round_up(raw, huge_page_size)};
+              if (aligned != raw) {
+                munmap(addr, aligned - raw);
+              }
+              if (const auto tail {huge_page_size - (aligned - raw)}; tail) {
+                munmap(reinterpret_cast<void*>(aligned + size), tail);
+              }
+              data_ptr = reinterpret_cast<void*>(aligned);
+              pages_kind = madvise(data_ptr, size, MADV_HUGEPAGE) ? Pages::Regular : Pages::Transparent;
+            } else {
+              pages = Pages::Regular;
+            }
+          }
+          if (pages == Pages::Regular) {
+            size = round_up(bytes, page_size);
+            if (auto addr {mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)}; addr != MAP_FAILED) {
+              data_ptr = addr;
+              pages_kind = Pages::Regular;
+            }
+          }
+          if (!data_ptr) {
+            throw std::bad_alloc{};
+          }
+          if (node >= 0) {
+            Tools::bindToNode(data_ptr, size, static_cast<unsigned>(node));
+          }
+#else
+          (void)pages;
+          (void)node;
+          size = (bytes + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+          data_ptr = std::aligned_alloc(alignof(std::max_align_t), size);
+          if (!data_ptr) {
+            throw std::bad_alloc{};
+          }
+#endif
+        }
+
+        ~Region() {
+          release();
+        }
+
+        Region(Region&) = delete;
+        Region(const Region&) = delete;
+        Region& operator = (Region&) = delete;
+        Region& operator = (const Region&) = delete;
+
+        /// @brief Move constructor
+        /// @param region Existing region
+        Region(Region&& region) noexcept
+        : data_ptr{std::exchange(region.data_ptr, nullptr)}, size{std::exchange(region.size, 0)}, pages_kind{region.pages_kind} {}
+
+        /// @brief Move operator
+        /// @param region Existing region
+        /// @return Region
+        Region& operator = (Region&& region) noexcept {
+          if (this != &region) {
+            release();
+            data_ptr = std::exchange(region.data_ptr, nullptr);
+            size = std::exchange(region.size, 0);
+            pages_kind = region.pages_kind;
+          }
+          return *this;
+        }
+
+        /// @brief Region start address
+        [[nodiscard]] void* data() const noexcept {return data_ptr;}
+        /// @brief Region size (rounded up to page size)
+        [[nodiscard]] size_t bytes() const noexcept {return size;}
+        /// @brief Pages kind region is backed by (could differ from requested one after fallback)
+        [[nodiscard]] Pages pages() const noexcept {return pages_kind;}
+
+      private :
+        void release() noexcept {
+          if (data_ptr) {
+#if defined(__linux__)
+            munmap(data_ptr, size);
+#else
+            std::free(data_ptr);
+#endif
+            data_ptr = nullptr;
+          }
+        }
+
+        void* data_ptr {nullptr};
+        size_t size {0};
+        Pages pages_kind {Pages::Regular};
+    };
+
+    /// @brief HashMap object constructed inside Region
+    template<typename Map> class Placed {
+      public :
+        using list_type = std::initializer_list<std::pair<typename Map::key_type, typename Map::mapped_type>>;
+
+        /// @brief Allocate region and create HashMap inside by initializer list
+        /// @param lst initializer list
+        /// @param pages Requested pages kind
+        /// @param node NUMA node to place map on, negative value for default system policy
+        explicit Placed(const list_type& lst, Pages pages = Pages::Huge, int node = -1)
+        : region{sizeof(Map), pages, node}, map{::new (region.data()) Map(lst)} {}
+
+        ~Placed() {
+          if (map) {
+            map->~Map();
+          }
+        }
+
+        Placed(Placed&) = delete;
+        Placed(const Placed&) = delete;
+        Placed& operator = (Placed&) = delete;
+        Placed& operator = (const Placed&) = delete;
+        Placed& operator = (Placed&&) = delete;
+
+        /// @brief Move constructor, map object stays in place
+        /// @param placed Existing placed map
+        Placed(Placed&& placed) noexcept : region{std::move(placed.region)}, map{std::exchange(placed.map, nullptr)} {}
+
+        /// @brief Get element by key
+        /// @param key KeyType (&, &&) value
+        /// @return Value (&) value
+        auto get(auto&& key) const noexcept {
+          return map->get(std::forward<decltype(key)>(key));
+        }
+
+        /// @brief Check if element exists in map
+        /// @param key KeyType (&, &&) value
+        /// @return true if exists, else false
+        bool exists(auto&& key) const noexcept {
+          return map->exists(std::forward<decltype(key)>(key));
+        }
+
+        /// @brief Placed HashMap object
+        [[nodiscard]] Map& operator*() noexcept {return *map;}
+        /// @brief Placed HashMap object, read only
+        [[nodiscard]] const Map& operator*() const noexcept {return *map;}
+        /// @brief Pages kind map is backed by
+        [[nodiscard]] Pages pages() const noexcept {return region.pages();}
+
+      private :
+        Region region;
+        Map* map {nullptr};
+    };
+
+    /// @brief HashMap replicas, one per NUMA node. Lookup is routed to replica of node current thread is running on
+    template<typename Map> class Replicated {
+      public :
+        using list_type = typename Placed<Map>::list_type;
+
+        /// @brief Create replica for every NUMA node by initializer list
+        /// @param lst initializer list
+        /// @param pages Requested pages kind
+        /// @param simulated_nodes Nodes number to simulate (CPUs are spread over nodes round-robin), 0 to use real topology
+        explicit Replicated(const list_type& lst, Pages pages = Pages::Huge, unsigned simulated_nodes = 0)
+        : cpu_nodes{Tools::cpuNodes()} {
+          const auto real_nodes {Tools::nodesNumber(cpu_nodes)};
+
+          if (simulated_nodes) {
+            nodes_number = simulated_nodes;
+            cpu_nodes.clear();
+          } else {
+            nodes_number = real_nodes;
+          }
+          replicas.reserve(nodes_number);
+          for (unsigned node{0}; node < nodes_number; ++node) {  //  No binding on single node box, simulated nodes share real ones
+            replicas.emplace_back(lst, pages, real_nodes > 1 ? static_cast<int>(node % real_nodes) : -1);
+          }
+        }
+
+        Replicated(Replicated&) = delete;
+        Replicated(const Replicated&) = delete;
+        Replicated& operator = (Replicated&) = delete;
+        Replicated& operator = (const Replicated&) = delete;
+
+        /// @brief Get element by key from local node replica
+        /// @param key KeyType (&, &&) value
+        /// @return Value (&) value
+        auto get(auto&& key) const noexcept {
+          return replicas[currentNode()].get(std::forward<decltype(key)>(key));
+        }
+
+        /// @brief Check if element exists in local node replica
+        /// @param key KeyType (&, &&) value
+        /// @return true if exists, else false
+        bool exists(auto&& key) const noexcept {
+          return replicas[currentNode()].exists(std::forward<decltype(key)>(key));
+        }
+
+        /// @brief Node current thread is running on (simulated one in simulation mode)
+        [[nodiscard]] unsigned currentNode() const noexcept {
+          const auto cpu {Tools::currentCpu()};
+          if (cpu < cpu_nodes.size()) {
+            return cpu_nodes[cpu];
+          }
+          return cpu % nodes_number;
+        }
+
+        /// @brief Replicas (nodes) number
+        [[nodiscard]] unsigned nodes() const noexcept {return nodes_number;}
+        /// @brief Replica for requested node
+        [[nodiscard]] Placed<Map>& replica(unsigned node) noexcept {return replicas[node];}
+        /// @brief Replica for requested node, read only
+        [[nodiscard]] const Placed<Map>& replica(unsigned node) const noexcept {return replicas[node];}
+
+      private :
+        std::vector<unsigned> cpu_nodes;
+        unsigned nodes_number {1};
+        std::vector<Placed<Map>> replicas;
+    };
+  }
+}
@@ -2,9 +2,12 @@
 #include "gmock/gmock.h"
 
 #include "../src/libHashMap.hpp"
+#include "../src/libHashMapPlacement.hpp"
 
 #include <typeinfo>
 #include <iostream>
+#include <thread>
+#include <sched.h>
 
 using namespace LibHashMap;
 using namespace LibHashMap::Tools;
@@ -44,7 +47,7 @@ template<typename Key, typename Value, std::unsigned_integral Size = size_t, Siz
         auto countHash = [this, &tmp_hash_tbl, &tmp_hash_sz, &tmp_key_tbl, &stor_sz](auto val) {
           auto hash {TestHashFunction<Key, Size>::countHash(std::forward<Key>(val.first))};
 
-          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl, hash)}; it_collision_node == tmp_hash_tbl.end()) { //  Just add new data node (no value duplication or cash collision case)
+          if (auto it_collision_node {std::ranges::find(tmp_hash_tbl.begin(), tmp_hash_tbl.begin() + tmp_hash_sz, hash)}; it_collision_node == tmp_hash_tbl.begin() + tmp_hash_sz) { //  Just add new data node (no value duplication or cash collision case)
             tmp_hash_tbl[tmp_hash_sz] = hash;
             tmp_key_tbl[tmp_hash_sz] = val.first;
             Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
@@ -52,7 +55,7 @@ template<typename Key, typename Value, std::unsigned_integral Size = size_t, Siz
             ++tmp_hash_sz;
             ++stor_sz;
           } else {
-            if (std::ranges::find(tmp_key_tbl, val.first) == tmp_key_tbl.end()) {  //  Hash collision case
+            if (std::ranges::find(tmp_key_tbl.begin(), tmp_key_tbl.begin() + tmp_hash_sz, val.first) == tmp_key_tbl.begin() + tmp_hash_sz) {  //  Hash collision case
               Tools::Node<Key, Value, Size, dim_size> node{std::forward<Key>(val.first), std::forward<Value>(val.second), std::forward<Size>(hash)};
               data_stor[pivot_number] = std::move(node);
               auto collision_node {std::ranges::find_if(data_stor.begin(), data_stor.begin() + (dim_size - (dim_size - pivot_number)), [&hash] (const auto& stor_node){return stor_node.hash == hash;})};
@@ -284,6 +287,167 @@ TEST(EXISTS, NoExists) {
 
 
 
+TEST(EXISTS, Search_Uint8_t) {
+  HashMap<int, char, uint8_t, 9> hash{{5,'e'}, {8,'h'}, {1,'a'}, {9,'i'}, {3,'c'}, {7,'g'}, {2,'b'}, {6,'f'}, {4,'d'}};
+  for (int count{1}; count <= 9; ++count) {
+    ASSERT_TRUE(hash.get(count));
+    EXPECT_EQ (*hash.get(count), 'a' + count - 1);
+  }
+  EXPECT_FALSE (hash.exists(0));
+  EXPECT_FALSE (hash.exists(10));
+}
+
+
+TEST(SipHash, Reference_Vector) {
+  using namespace std::literals;
+  //  SipHash-2-4 reference: key 00..0f, message 00..0e
+  constexpr SipHashFunction<std::string_view, uint64_t, 2, 4> hash{0x0706050403020100, 0x0f0e0d0c0b0a0908};
+  constexpr auto msg {"\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x0b\x0c\x0d\x0e"sv};
+  static_assert(hash(msg) == 0xa129ca6149be45e5);
+  EXPECT_EQ (hash(msg), 0xa129ca6149be45e5);
+}
+
+TEST(SipHash, Integral_As_Bytes) {
+  using namespace std::literals;
+  constexpr SipHashFunction<std::string_view> bytes_hash{1, 2};
+  constexpr SipHashFunction<uint64_t> word_hash{1, 2};
+  constexpr SipHashFunction<uint16_t> short_hash{1, 2};
+  static_assert(word_hash(uint64_t{0x0706050403020100}) == bytes_hash("\x00\x01\x02\x03\x04\x05\x06\x07"sv));
+  static_assert(short_hash(uint16_t{0x0201}) == bytes_hash("\x01\x02"sv));
+  EXPECT_EQ (short_hash(uint16_t{0x0201}), bytes_hash("\x01\x02"sv));
+}
+
+TEST(SipHash, Seed) {
+  constexpr SipHashFunction<int> compile_time_hash{};
+  static_assert(compile_time_hash.seed() == build_seed);
+  SipHashFunction<int> hash_a{}, hash_b{};
+  EXPECT_NE (hash_a.seed(), hash_b.seed());
+  EXPECT_NE (hash_a(12345), hash_b(12345));
+  EXPECT_EQ (hash_a(12345), hash_a(12345));
+}
+
+TEST(SipHash, HashMap_Int) {
+  HashMap<int, char, uint8_t, 9, SipHashFunction<int, uint8_t>> hash{{5,'e'}, {8,'h'}, {1,'a'}, {9,'i'}, {3,'c'}, {7,'g'}, {2,'b'}, {6,'f'}, {4,'d'}};
+  for (int count{1}; count <= 9; ++count) {
+    ASSERT_TRUE(hash.get(count));
+    EXPECT_EQ (*hash.get(count), 'a' + count - 1);
+  }
+  EXPECT_FALSE (hash.exists(0));
+  EXPECT_FALSE (hash.exists(10));
+}
+
+TEST(SipHash, HashMap_Key_Conversion) {
+  using namespace std::literals;
+  HashMap<uint64_t, char, size_t, 3, SipHashFunction<uint64_t>> hash{{2,'b'}, {3,'c'}, {1,'a'}};
+  ASSERT_TRUE(hash.get(1));
+  EXPECT_EQ (*hash.get(1), 'a');
+  EXPECT_EQ (*hash.get(uint8_t{3}), 'c');
+  EXPECT_TRUE (hash.exists(2));
+  EXPECT_FALSE (hash.exists(4));
+
+  HashMap<std::string, char, size_t, 3, SipHashFunction<std::string>> str_hash{{"Two"s,'b'}, {"Three"s,'c'}, {"One"s,'a'}};
+  ASSERT_TRUE(str_hash.get("Two"sv));
+  EXPECT_EQ (*str_hash.get("Two"sv), 'b');
+  EXPECT_TRUE (str_hash.exists("One"));
+}
+
+TEST(SipHash, HashMap_Constexpr) {
+  static constexpr HashMap<int, char, uint8_t, 3, SipHashFunction<int, uint8_t>> hash{{2,'b'}, {3,'c'}, {1,'a'}};
+  static_assert(*hash.get(1) == 'a');
+  static_assert(*hash.get(3) == 'c');
+  static_assert(!hash.exists(4));
+  ASSERT_TRUE(hash.get(2));
+  EXPECT_EQ (*hash.get(2), 'b');
+}
+
+TEST(SipHash, HashMap_String) {
+  using namespace std::literals;
+  HashMap<std::string, char, size_t, 3, SipHashFunction<std::string>> hash{{"Two"s,'b'}, {"Three"s,'c'}, {"One"s,'a'}};
+  ASSERT_TRUE(hash.get("One"s));
+  ASSERT_TRUE(hash.get("Two"s));
+  ASSERT_TRUE(hash.get("Three"s));
+  EXPECT_EQ (*hash.get("One"s), 'a');
+  EXPECT_EQ (*hash.get("Two"s), 'b');
+  EXPECT_EQ (*hash.get("Three"s), 'c');
+  EXPECT_FALSE (hash.exists("Four"s));
+}
+
+
+TEST(Placement, HugePages) {
+  using namespace LibHashMap::Placement;
+  Placed<HashMap<int, char, uint8_t, 3>> hash{{{2,'b'}, {3,'c'}, {1,'a'}}};
+  ASSERT_TRUE(hash.get(1));
+  ASSERT_TRUE(hash.get(2));
+  ASSERT_TRUE(hash.get(3));
+  EXPECT_EQ (*hash.get(1), 'a');
+  EXPECT_EQ (*hash.get(2), 'b');
+  EXPECT_EQ (*hash.get(3), 'c');
+  EXPECT_FALSE (hash.exists(4));
+  if (hash.pages() != Pages::Regular) {
+    EXPECT_EQ (reinterpret_cast<uintptr_t>(&*hash) % huge_page_size, 0);
+  }
+  const auto& frozen {hash};
+  static_assert(std::is_same_v<decltype(*frozen), const HashMap<int, char, uint8_t, 3>&>);
+  static_assert(!std::is_convertible_v<size_t, Region>);
+  ASSERT_TRUE(frozen.get(3));
+  EXPECT_EQ (*frozen.get(3), 'c');
+  EXPECT_FALSE (frozen.exists(4));
+}
+
+TEST(Placement, RegularPages) {
+  using namespace LibHashMap::Placement;
+  Placed<HashMap<int, char, uint8_t, 3>> hash{{{2,'b'}, {3,'c'}, {1,'a'}}, Pages::Regular};
+  EXPECT_EQ (hash.pages(), Pages::Regular);
+  ASSERT_TRUE(hash.get(2));
+  EXPECT_EQ (*hash.get(2), 'b');
+}
+
+TEST(Placement, Replicated_Simulated_Nodes) {
+  using namespace LibHashMap::Placement;
+  Replicated<HashMap<int, char, uint8_t, 3>> hash{{{2,'b'}, {3,'c'}, {1,'a'}}, Pages::Huge, 4};
+  ASSERT_EQ (hash.nodes(), 4);
+  for (unsigned node{0}; node < hash.nodes(); ++node) {
+    ASSERT_TRUE(hash.replica(node).get(3));
+    EXPECT_EQ (*hash.replica(node).get(3), 'c');
+    if (node) {
+      EXPECT_NE (&*hash.replica(node), &*hash.replica(node - 1));
+    }
+  }
+  //  Every thread is pinned to one of allowed CPUs and looks up through shared read only map,
+  //  lookup should be served by replica of CPU simulated node
+  const auto& frozen {hash};
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  ASSERT_EQ (sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  std::vector<std::thread> threads;
+  for (int cpu{0}; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &allowed)) {
+      continue;
+    }
+    threads.emplace_back([&hash = frozen, cpu] {
+      cpu_set_t pinned;
+      CPU_ZERO(&pinned);
+      CPU_SET(cpu, &pinned);
+      ASSERT_EQ (sched_setaffinity(0, sizeof(pinned), &pinned), 0);
+      ASSERT_EQ (sched_getcpu(), cpu);
+      const auto node {hash.currentNode()};
+      EXPECT_EQ (node, static_cast<unsigned>(cpu) % hash.nodes());
+
+      const auto val {hash.get(1)};
+      ASSERT_TRUE(val);
+      EXPECT_EQ (*val, 'a');
+      const auto replica {reinterpret_cast<const char*>(&*hash.replica(node))};
+      const auto val_addr {reinterpret_cast<const char*>(val)};
+      EXPECT_TRUE (val_addr >= replica && val_addr < replica + sizeof(*hash.replica(node)));
+      EXPECT_FALSE (hash.exists(0));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+
 GTEST_API_ int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();